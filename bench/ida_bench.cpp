@@ -0,0 +1,652 @@
+// Benchmark for the IDA* engines on the 15-puzzle.
+//
+// Solves a fixed set of instances and writes, per instance, the solution
+// cost, node counts, nodes per second, the threshold and node count of every
+// iteration, the share of time spent evaluating the heuristic and the change
+// in resident memory across the solve, as JSON. The process's peak resident
+// memory is a lifetime maximum and so only appears in the summary. A
+// one-line summary per instance goes to stderr. Times and rates cover the
+// search iterations only; clearing the transposition table, a sweep over all
+// of it, happens before the clock starts.
+//
+// Instances come either from a file in Korf's format (one instance per line,
+// sixteen tile numbers with 0 for the blank, optionally preceded by an
+// instance number; '#' starts a comment) or, with --random, from seeded
+// random walks back from the goal, which are identical on every platform.
+// The default is Korf's 100 instances in bench/korf100.txt, solved with the
+// 5-5-5 additive PDBs.
+//
+// The heuristic share is measured differentially, because reading the clock
+// costs more than a heuristic call. Two extra single-threaded passes search
+// the same tree, one plainly and one evaluating the heuristic
+// extra_evaluations more times per call; the difference in their thread CPU
+// time, divided by extra_evaluations, is the time spent in the heuristic.
+// Each pass is run profile_rounds times and the fastest kept, so profiling
+// costs several times the search itself; --no-profile skips it. The
+// repeated calls find their data in cache, so for memory-bound heuristics
+// such as PDBs the share is a lower bound. A difference below the noise floor
+// is reported as unknown (null) rather than as zero.
+
+#include <ida/ida.hpp>
+#include <ida/parallel.hpp>
+#include <ida/pattern_database.hpp>
+#include <ida/sliding_tile.hpp>
+#include <ida/transposition_table.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <sys/resource.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace {
+
+using Puzzle = ida::FifteenPuzzle;
+using State = Puzzle::State;
+using Pattern = ida::TilePattern<4, 4>;
+using Clock = std::chrono::steady_clock;
+using BenchResult = ida::Result<Puzzle::Move, Puzzle::cost_type>;
+
+#ifndef IDA_BENCH_INSTANCES
+#define IDA_BENCH_INSTANCES "korf100.txt"
+#endif
+
+const char usage[] =
+    "usage: ida_bench [options]\n"
+    "  --instances FILE   Korf-format instance file (default: Korf's 100,\n"
+    "                     " IDA_BENCH_INSTANCES ")\n"
+    "  --random           solve random walks from the goal instead\n"
+    "  --count N          number of random-walk instances (default 10)\n"
+    "  --walk N           length of each random walk (default 60)\n"
+    "  --seed N           random-walk seed (default 1)\n"
+    "  --heuristic NAME   manhattan or pdb (default pdb)\n"
+    "  --pdb-dir DIR      where 5-5-5 PDBs are cached (default .)\n"
+    "  --threads N        worker threads; 1 runs the sequential engine\n"
+    "  --tt-mb N          transposition table size in MiB (default 0: off)\n"
+    "  --json FILE        JSON output file (default: stdout)\n"
+    "  --no-profile       skip the heuristic timing pass\n";
+
+struct Options {
+    std::string instances = IDA_BENCH_INSTANCES;
+    bool random = false;
+    unsigned count = 10;
+    unsigned walk = 60;
+    std::uint64_t seed = 1;
+    std::string heuristic = "pdb";
+    std::string pdb_dir = ".";
+    unsigned threads = 1;
+    std::size_t tt_mb = 0;
+    std::string json;
+    bool profile = true;
+};
+
+struct Instance {
+    std::string id;
+    State state;
+};
+
+struct Measurement {
+    BenchResult result;
+    double seconds = 0;
+    double heuristic_share = -1;  // -1: not measured or unknown
+    ida::TableCounters table;
+    long long rss_delta_bytes = 0;
+};
+
+std::uint64_t peak_rss_bytes() {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+#ifdef __APPLE__
+    return static_cast<std::uint64_t>(usage.ru_maxrss);
+#else
+    return static_cast<std::uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+}
+
+// Current resident memory, or 0 where /proc/self/statm is not available.
+std::uint64_t current_rss_bytes() {
+    std::ifstream statm("/proc/self/statm");
+    std::uint64_t size = 0;
+    std::uint64_t resident = 0;
+    if (!(statm >> size >> resident))
+        return 0;
+    return resident * static_cast<std::uint64_t>(::sysconf(_SC_PAGESIZE));
+}
+
+// splitmix64, so that random walks do not depend on the standard library.
+std::uint64_t next_random(std::uint64_t& state) {
+    std::uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+std::vector<Instance> random_instances(const Options& o) {
+    const Puzzle puzzle;
+    std::uint64_t rng = o.seed;
+    std::vector<Instance> instances;
+    for (unsigned i = 0; i < o.count; ++i) {
+        State s = Puzzle::goal();
+        Puzzle::Move moves[Puzzle::max_branching];
+        Puzzle::Move last{};
+        for (unsigned step = 0; step < o.walk; ++step) {
+            const std::size_t n =
+                puzzle.generate(s, step ? &last : nullptr, moves);
+            last = moves[next_random(rng) % n];
+            puzzle.apply(s, last);
+        }
+        instances.push_back(Instance{"walk-" + std::to_string(i + 1), s});
+    }
+    return instances;
+}
+
+std::vector<Instance> read_instances(const std::string& path) {
+    std::ifstream in(path);
+    if (!in)
+        throw std::runtime_error("cannot open " + path);
+    std::vector<Instance> instances;
+    std::string line;
+    for (unsigned number = 1; std::getline(in, line); ++number) {
+        std::istringstream fields(line.substr(0, line.find('#')));
+        std::vector<int> values;
+        for (int v; fields >> v;)
+            values.push_back(v);
+        if (values.empty())
+            continue;
+
+        std::string id = std::to_string(instances.size() + 1);
+        if (values.size() == Puzzle::size + 1) {
+            id = std::to_string(values.front());
+            values.erase(values.begin());
+        }
+        std::array<int, Puzzle::size> tiles;
+        bool seen[Puzzle::size] = {};
+        bool valid = values.size() == Puzzle::size;
+        for (int i = 0; valid && i < Puzzle::size; ++i) {
+            valid = values[i] >= 0 && values[i] < Puzzle::size &&
+                    !seen[values[i]];
+            if (valid)
+                seen[values[i]] = true;
+            tiles[i] = values[i];
+        }
+        if (!valid || !Puzzle::solvable(Puzzle::from_tiles(tiles)))
+            throw std::runtime_error(path + ":" + std::to_string(number) +
+                                     ": not a solvable 15-puzzle instance");
+        instances.push_back(Instance{id, Puzzle::from_tiles(tiles)});
+    }
+    return instances;
+}
+
+// Loads the 5-5-5 additive PDBs from the PDB directory, building (on all
+// hardware threads) and saving any that are missing.
+ida::PdbHeuristic<Pattern> load_pdbs(const Options& o, double& build_seconds) {
+    const std::vector<std::vector<int>> patterns = {
+        {1, 2, 3, 4, 5}, {6, 7, 8, 9, 10}, {11, 12, 13, 14, 15}};
+    ida::PdbHeuristic<Pattern> heuristic;
+    build_seconds = 0;
+    for (const std::vector<int>& tiles : patterns) {
+        const Pattern pattern(tiles);
+        std::string path = o.pdb_dir + "/15puzzle";
+        for (int t : tiles)
+            path += "-" + std::to_string(t);
+        path += ".pdb";
+
+        std::shared_ptr<const ida::PatternDatabase> pdb;
+        try {
+            pdb = std::make_shared<const ida::PatternDatabase>(
+                ida::PatternDatabase::load(path));
+        } catch (const std::runtime_error&) {
+            const Clock::time_point start = Clock::now();
+            ida::PatternDatabase::build(pattern).save(path);
+            build_seconds +=
+                std::chrono::duration<double>(Clock::now() - start).count();
+            pdb = std::make_shared<const ida::PatternDatabase>(
+                ida::PatternDatabase::load(path));
+        }
+        heuristic.add(pattern, std::move(pdb));
+    }
+    return heuristic;
+}
+
+constexpr unsigned extra_evaluations = 4;
+// Both passes are run this many times, interleaved, and the fastest of each
+// is kept, which filters out interruptions.
+constexpr unsigned profile_rounds = 3;
+// Passes shorter than this, or extra time below this fraction of the plain
+// pass, are too close to timing noise to give a share.
+constexpr double min_profile_seconds = 0.01;
+constexpr double noise_floor = 0.05;
+
+// CPU time consumed by the calling thread.
+double thread_seconds() {
+    timespec t;
+    ::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &t);
+    return static_cast<double>(t.tv_sec) + t.tv_nsec * 1e-9;
+}
+
+// Makes `value` look read and possibly modified, so that repeated calls of a
+// pure function on it are neither merged nor dropped.
+template <class T>
+void clobber(const T& value) {
+#if defined(__GNUC__)
+    asm volatile("" : : "r"(&value) : "memory");
+#else
+    static const void* volatile sink;
+    sink = &value;
+#endif
+}
+
+// Wraps a heuristic and evaluates it extra_evaluations more times per call.
+template <class Heuristic>
+class RepeatedHeuristic {
+public:
+    explicit RepeatedHeuristic(const Heuristic& heuristic)
+        : heuristic_(heuristic) {}
+
+    int operator()(const State& s) const {
+        const int h = heuristic_(s);
+        for (unsigned i = 0; i < extra_evaluations; ++i) {
+            clobber(s);
+            const int again = heuristic_(s);
+            clobber(again);
+        }
+        return h;
+    }
+
+private:
+    Heuristic heuristic_;
+};
+
+// Share of the plain pass spent in the heuristic, or -1 if the passes do not
+// separate it from noise.
+double heuristic_share(double plain_seconds, double repeated_seconds) {
+    if (plain_seconds < min_profile_seconds ||
+        repeated_seconds - plain_seconds < noise_floor * plain_seconds)
+        return -1;
+    const double share =
+        (repeated_seconds - plain_seconds) / extra_evaluations / plain_seconds;
+    return share <= 1 ? share : -1;
+}
+
+template <class Heuristic, class Table>
+BenchResult solve(const Options& o, const State& root,
+                  const Heuristic& heuristic, Table* table) {
+    if (o.threads > 1) {
+        ida::ParallelOptions options;
+        options.threads = o.threads;
+        ida::ParallelSearch<State, Puzzle, Heuristic, Table> search(
+            Puzzle(), heuristic, options, table);
+        return search.solve(root);
+    }
+    ida::Search<State, Puzzle, Heuristic, Table> search(Puzzle(), heuristic,
+                                                        table);
+    return search.solve(root);
+}
+
+template <class Heuristic, class Table>
+Measurement measure(const Options& o, const State& root,
+                    const Heuristic& heuristic, Table* table) {
+    constexpr bool has_table = !std::is_same<Table, ida::NoTable>::value;
+    Measurement m;
+    if constexpr (has_table)
+        table->reset_counters();
+    const std::uint64_t rss_before = current_rss_bytes();
+    m.result = solve(o, root, heuristic, table);
+    // The iterations alone, leaving out the table clear and set-up that
+    // solve() does before the first node.
+    for (const auto& it : m.result.per_iteration)
+        m.seconds += it.seconds;
+    m.rss_delta_bytes = static_cast<long long>(current_rss_bytes()) -
+                        static_cast<long long>(rss_before);
+    if constexpr (has_table)
+        m.table = table->counters();
+
+    if (o.profile) {
+        Options sequential = o;
+        sequential.threads = 1;
+        const RepeatedHeuristic<Heuristic> repeated(heuristic);
+        // Both passes start by clearing the table, which is not search time.
+        double clear = 0;
+        if constexpr (has_table) {
+            const double clear_start = thread_seconds();
+            table->clear();
+            clear = thread_seconds() - clear_start;
+        }
+        double plain = 0;
+        double again = 0;
+        for (unsigned round = 0; round < profile_rounds; ++round) {
+            const double plain_start = thread_seconds();
+            solve(sequential, root, heuristic, table);
+            const double repeated_start = thread_seconds();
+            solve(sequential, root, repeated, table);
+            const double end = thread_seconds();
+            const double p = repeated_start - plain_start - clear;
+            const double r = end - repeated_start - clear;
+            plain = round == 0 ? p : std::min(plain, p);
+            again = round == 0 ? r : std::min(again, r);
+        }
+        m.heuristic_share = heuristic_share(plain, again);
+    }
+    return m;
+}
+
+// Minimal streaming JSON writer; commas are tracked per nesting level.
+class JsonWriter {
+public:
+    explicit JsonWriter(std::ostream& out) : out_(out) {}
+
+    JsonWriter& begin_object() { return open('{'); }
+    JsonWriter& end_object() { return close('}'); }
+    JsonWriter& begin_array() { return open('['); }
+    JsonWriter& end_array() { return close(']'); }
+
+    JsonWriter& key(const std::string& name) {
+        separate();
+        write_string(name);
+        out_ << ':';
+        after_key_ = true;
+        return *this;
+    }
+
+    JsonWriter& value(const std::string& s) {
+        separate();
+        write_string(s);
+        return *this;
+    }
+    JsonWriter& value(const char* s) { return value(std::string(s)); }
+    JsonWriter& value(bool b) {
+        separate();
+        out_ << (b ? "true" : "false");
+        return *this;
+    }
+    JsonWriter& value(int v) { return number(std::to_string(v)); }
+    JsonWriter& value(unsigned v) { return number(std::to_string(v)); }
+    JsonWriter& value(unsigned long v) { return number(std::to_string(v)); }
+    JsonWriter& value(unsigned long long v) {
+        return number(std::to_string(v));
+    }
+    JsonWriter& value(long long v) { return number(std::to_string(v)); }
+    JsonWriter& null() { return number("null"); }
+    JsonWriter& value(double v) {
+        if (v != v || v - v != 0)
+            return null();
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%.9g", v);
+        return number(buffer);
+    }
+
+    template <class T>
+    JsonWriter& field(const std::string& name, const T& v) {
+        return key(name).value(v);
+    }
+
+private:
+    JsonWriter& open(char c) {
+        separate();
+        out_ << c;
+        first_.push_back(true);
+        return *this;
+    }
+    JsonWriter& close(char c) {
+        first_.pop_back();
+        out_ << c;
+        return *this;
+    }
+    JsonWriter& number(const std::string& text) {
+        separate();
+        out_ << text;
+        return *this;
+    }
+    void separate() {
+        if (after_key_) {
+            after_key_ = false;
+            return;
+        }
+        if (!first_.empty()) {
+            if (!first_.back())
+                out_ << ',';
+            first_.back() = false;
+        }
+    }
+    void write_string(const std::string& s) {
+        out_ << '"';
+        for (char c : s) {
+            if (c == '"' || c == '\\')
+                out_ << '\\' << c;
+            else if (static_cast<unsigned char>(c) < 0x20)
+                out_ << ' ';
+            else
+                out_ << c;
+        }
+        out_ << '"';
+    }
+
+    std::ostream& out_;
+    std::vector<bool> first_;
+    bool after_key_ = false;
+};
+
+template <class Heuristic>
+void run(const Options& o, const std::vector<Instance>& instances,
+         const Heuristic& heuristic, ida::TranspositionTable* table,
+         JsonWriter& json) {
+    std::uint64_t total_expanded = 0;
+    std::uint64_t total_generated = 0;
+    double total_seconds = 0;
+    unsigned solved = 0;
+
+    json.key("instances").begin_array();
+    for (const Instance& instance : instances) {
+        const Measurement m =
+            table ? measure(o, instance.state, heuristic, table)
+                  : measure(o, instance.state, heuristic,
+                            static_cast<ida::NoTable*>(nullptr));
+        const BenchResult& r = m.result;
+        const double rate = m.seconds > 0 ? r.nodes_generated / m.seconds : 0;
+        total_expanded += r.nodes_expanded;
+        total_generated += r.nodes_generated;
+        total_seconds += m.seconds;
+        solved += r.found;
+
+        json.begin_object();
+        json.field("id", instance.id);
+        json.key("tiles").begin_array();
+        for (std::uint8_t t : instance.state.tiles)
+            json.value(static_cast<unsigned>(t));
+        json.end_array();
+        json.field("found", r.found);
+        json.field("cost", r.cost);
+        json.field("initial_heuristic", heuristic(instance.state));
+        json.field("seconds", m.seconds);
+        json.field("nodes_expanded",
+                   static_cast<unsigned long long>(r.nodes_expanded));
+        json.field("nodes_generated",
+                   static_cast<unsigned long long>(r.nodes_generated));
+        json.field("nodes_per_second", rate);
+        json.key("iterations").begin_array();
+        for (const auto& it : r.per_iteration) {
+            json.begin_object();
+            json.field("threshold", it.threshold);
+            json.field("nodes_expanded",
+                       static_cast<unsigned long long>(it.nodes_expanded));
+            json.field("nodes_generated",
+                       static_cast<unsigned long long>(it.nodes_generated));
+            json.field("seconds", it.seconds);
+            json.end_object();
+        }
+        json.end_array();
+        if (o.profile) {
+            json.key("heuristic_time_share");
+            if (m.heuristic_share >= 0)
+                json.value(m.heuristic_share);
+            else
+                json.null();
+        }
+        if (table) {
+            json.key("transposition_table").begin_object();
+            json.field("hits", static_cast<unsigned long long>(m.table.hits));
+            json.field("misses",
+                       static_cast<unsigned long long>(m.table.misses));
+            json.field("cutoffs",
+                       static_cast<unsigned long long>(m.table.cutoffs));
+            json.field("replacements",
+                       static_cast<unsigned long long>(m.table.replacements));
+            json.end_object();
+        }
+        json.field("rss_delta_bytes", m.rss_delta_bytes);
+        json.end_object();
+
+        std::fprintf(stderr,
+                     "%-10s cost %3d  %12llu nodes  %8.3f s  %7.2f Mnodes/s",
+                     instance.id.c_str(), r.cost,
+                     static_cast<unsigned long long>(r.nodes_generated),
+                     m.seconds, rate * 1e-6);
+        if (o.profile && m.heuristic_share >= 0)
+            std::fprintf(stderr, "  h %4.1f%%", m.heuristic_share * 100);
+        else if (o.profile)
+            std::fprintf(stderr, "  h    n/a");
+        std::fprintf(stderr, "\n");
+    }
+    json.end_array();
+
+    json.key("summary").begin_object();
+    json.field("instances", static_cast<unsigned>(instances.size()));
+    json.field("solved", solved);
+    json.field("seconds", total_seconds);
+    json.field("nodes_expanded",
+               static_cast<unsigned long long>(total_expanded));
+    json.field("nodes_generated",
+               static_cast<unsigned long long>(total_generated));
+    json.field("nodes_per_second",
+               total_seconds > 0 ? total_generated / total_seconds : 0.0);
+    json.field("peak_rss_bytes",
+               static_cast<unsigned long long>(peak_rss_bytes()));
+    json.end_object();
+}
+
+bool parse_options(int argc, char** argv, Options& o) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--no-profile") {
+            o.profile = false;
+            continue;
+        }
+        if (arg == "--random") {
+            o.random = true;
+            continue;
+        }
+        if (arg == "--help" || i + 1 == argc)
+            return false;
+        const std::string v = argv[++i];
+        if (arg == "--instances")
+            o.instances = v;
+        else if (arg == "--count")
+            o.count = static_cast<unsigned>(std::stoul(v));
+        else if (arg == "--walk")
+            o.walk = static_cast<unsigned>(std::stoul(v));
+        else if (arg == "--seed")
+            o.seed = std::stoull(v);
+        else if (arg == "--heuristic")
+            o.heuristic = v;
+        else if (arg == "--pdb-dir")
+            o.pdb_dir = v;
+        else if (arg == "--threads")
+            o.threads = static_cast<unsigned>(std::stoul(v));
+        else if (arg == "--tt-mb")
+            o.tt_mb = static_cast<std::size_t>(std::stoull(v));
+        else if (arg == "--json")
+            o.json = v;
+        else
+            return false;
+    }
+    return o.heuristic == "manhattan" || o.heuristic == "pdb";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options o;
+    try {
+        if (!parse_options(argc, argv, o)) {
+            std::fputs(usage, stderr);
+            return 2;
+        }
+    } catch (const std::exception&) {
+        std::fputs(usage, stderr);
+        return 2;
+    }
+    if (o.threads == 0)
+        o.threads = std::max(1u, std::thread::hardware_concurrency());
+
+    try {
+        const std::vector<Instance> instances =
+            o.random ? random_instances(o) : read_instances(o.instances);
+
+        std::ofstream file;
+        if (!o.json.empty()) {
+            file.open(o.json);
+            if (!file)
+                throw std::runtime_error("cannot create " + o.json);
+        }
+        std::ostream& out = o.json.empty() ? std::cout : file;
+        JsonWriter json(out);
+
+        json.begin_object();
+        json.field("benchmark", "ida");
+        json.field("schema_version", 2);
+        json.key("config").begin_object();
+        json.field("domain", "15-puzzle");
+        json.field("heuristic", o.heuristic);
+        json.field("threads", o.threads);
+        // The table rounds its size down to a power of two buckets.
+        std::unique_ptr<ida::TranspositionTable> table;
+        if (o.tt_mb > 0)
+            table.reset(new ida::TranspositionTable(o.tt_mb << 20));
+        json.field("transposition_table_bytes",
+                   static_cast<unsigned long long>(
+                       table ? table->memory_bytes() : 0));
+        if (o.random) {
+            json.field("instances", "random-walk");
+            json.field("count", o.count);
+            json.field("walk", o.walk);
+            json.field("seed", static_cast<unsigned long long>(o.seed));
+        } else {
+            json.field("instances", o.instances);
+        }
+
+        if (o.heuristic == "pdb") {
+            double build_seconds = 0;
+            const auto heuristic = load_pdbs(o, build_seconds);
+            json.field("pdb_build_seconds", build_seconds);
+            json.end_object();
+            run(o, instances, heuristic, table.get(), json);
+        } else {
+            json.end_object();
+            run(o, instances, ida::Manhattan<4, 4>(), table.get(), json);
+        }
+        json.end_object();
+        out << '\n';
+        if (!out)
+            throw std::runtime_error("cannot write results");
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "ida_bench: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,305 @@
+// Iterative-deepening A* (IDA*) search.
+//
+// The engine is templated on the state type, the successor generator and the
+// heuristic, so that node expansion compiles down to direct, inlinable calls.
+// Search runs in place on a single state: moves are applied on the way down
+// and undone on the way back up, and the depth-first stack is an explicit
+// array of frames that is reused across iterations.
+//
+// A successor generator `Successors` must provide:
+//
+//     using move_type = ...;                       // trivially copyable
+//     using cost_type = ...;                       // arithmetic
+//     static constexpr std::size_t max_branching;  // upper bound on moves
+//
+//     bool is_goal(const State&) const;
+//     // Writes at most max_branching moves to `out` and returns the count.
+//     // `parent` is the move that produced `s`, or nullptr at the root; it
+//     // may be used to prune immediate move reversals.
+//     std::size_t generate(const State& s, const move_type* parent,
+//                          move_type* out) const;
+//     cost_type apply(State&, const move_type&) const;  // returns step cost
+//     void undo(State&, const move_type&) const;
+//
+// A heuristic is any callable `cost_type(const State&)` that never
+// overestimates the remaining cost to a goal.
+//
+// A transposition table (see transposition_table.hpp) can be plugged in as
+// the optional `Table` parameter. The successor generator then also has to
+// provide `std::uint64_t hash(const State&) const`, and cost_type must be
+// integral. The table treats equal hashes as equal states, so `hash` must be
+// injective on reachable states; a collision can prune the only optimal path.
+
+#ifndef IDA_IDA_HPP
+#define IDA_IDA_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ida {
+
+// Table parameter for searches without a transposition table.
+struct NoTable {
+    struct counters_type {};
+};
+
+template <class Cost>
+struct IterationStats {
+    Cost threshold{};
+    std::uint64_t nodes_expanded = 0;
+    std::uint64_t nodes_generated = 0;
+    double seconds = 0;
+};
+
+template <class Move, class Cost>
+struct Result {
+    bool found = false;
+    Cost cost{};
+    std::vector<Move> path;
+
+    std::uint64_t nodes_expanded = 0;
+    std::uint64_t nodes_generated = 0;
+    std::uint32_t iterations = 0;
+    // One entry per threshold iteration, in order.
+    std::vector<IterationStats<Cost>> per_iteration;
+};
+
+namespace detail {
+
+// Appends the statistics of an iteration that started at `start`, when the
+// result's counters stood at `before`.
+template <class Move, class Cost>
+void record_iteration(Result<Move, Cost>& result, Cost threshold,
+                      const IterationStats<Cost>& before,
+                      std::chrono::steady_clock::time_point start) {
+    IterationStats<Cost> it;
+    it.threshold = threshold;
+    it.nodes_expanded = result.nodes_expanded - before.nodes_expanded;
+    it.nodes_generated = result.nodes_generated - before.nodes_generated;
+    it.seconds = std::chrono::duration<double>(
+                     std::chrono::steady_clock::now() - start)
+                     .count();
+    result.per_iteration.push_back(it);
+}
+
+template <class Move, class Cost>
+IterationStats<Cost> counters_of(const Result<Move, Cost>& result) {
+    IterationStats<Cost> c;
+    c.nodes_expanded = result.nodes_expanded;
+    c.nodes_generated = result.nodes_generated;
+    return c;
+}
+
+}  // namespace detail
+
+template <class State, class Successors, class Heuristic,
+          class Table = NoTable>
+class Search {
+public:
+    using state_type = State;
+    using move_type = typename Successors::move_type;
+    using cost_type = typename Successors::cost_type;
+    using result_type = Result<move_type, cost_type>;
+
+    static_assert(std::is_arithmetic<cost_type>::value,
+                  "cost_type must be arithmetic");
+    static_assert(std::is_trivially_copyable<move_type>::value,
+                  "move_type must be trivially copyable");
+    static_assert(Successors::max_branching > 0,
+                  "max_branching must be positive");
+    static_assert(std::is_same<Table, NoTable>::value ||
+                      std::is_integral<cost_type>::value,
+                  "a transposition table needs an integral cost_type");
+
+    static constexpr cost_type infinity = std::numeric_limits<cost_type>::max();
+
+    // `table` may be null, in which case no duplicate detection is done. It
+    // is not owned and may be shared with other searches running in
+    // parallel on the same root.
+    explicit Search(Successors successors = Successors(),
+                    Heuristic heuristic = Heuristic(), Table* table = nullptr)
+        : successors_(std::move(successors)),
+          heuristic_(std::move(heuristic)),
+          table_(table) {}
+
+    const Successors& successors() const { return successors_; }
+    const Heuristic& heuristic() const { return heuristic_; }
+    Table* table() const { return table_; }
+
+    // Searches for an optimal path from `root`. Iterations stop once the
+    // threshold would exceed `max_bound`, in which case the result is not
+    // found. The transposition table, if any, is cleared first.
+    result_type solve(State root, cost_type max_bound = infinity) {
+        result_type result;
+        if constexpr (has_table)
+            if (table_)
+                table_->clear();
+        cost_type bound = heuristic_(root);
+        while (bound <= max_bound) {
+            ++result.iterations;
+            const auto before = detail::counters_of(result);
+            const auto start = std::chrono::steady_clock::now();
+            cost_type next = infinity;
+            const bool found = bounded_search(root, cost_type(0), nullptr,
+                                              bound, next, result);
+            detail::record_iteration(result, bound, before, start);
+            if (found) {
+                result.found = true;
+                return result;
+            }
+            if (next == infinity)
+                break;
+            bound = next;
+        }
+        return result;
+    }
+
+    // One cost-bounded depth-first pass below `s`, which has already been
+    // reached at cost `g0` via `parent`. Returns true if a goal was found, in
+    // which case the moves from `s` are appended to `result.path`. The
+    // smallest f-value that exceeded `bound` is folded into `next`. If `stop`
+    // is given, the pass is abandoned as soon as it is set. `s` is restored
+    // before returning.
+    bool bounded_search(State& s, cost_type g0, const move_type* parent,
+                        cost_type bound, cost_type& next, result_type& result,
+                        const std::atomic<bool>* stop = nullptr) {
+        const bool found =
+            search_below(s, g0, parent, bound, next, result, stop);
+        if constexpr (has_table) {
+            if (table_) {
+                table_->record(counters_);
+                counters_ = typename Table::counters_type();
+            }
+        }
+        return found;
+    }
+
+private:
+    static constexpr bool has_table = !std::is_same<Table, NoTable>::value;
+
+    struct Frame {
+        move_type moves[Successors::max_branching];
+        std::size_t count;
+        std::size_t next;
+        cost_type g;
+    };
+
+    // True if the transposition table shows that the subtree below `s` need
+    // not be searched again.
+    bool transposed(const State& s, cost_type g, cost_type bound) {
+        if constexpr (has_table) {
+            return table_ &&
+                   table_->visit(successors_.hash(s),
+                                 static_cast<std::uint32_t>(g),
+                                 static_cast<std::uint32_t>(bound), counters_);
+        } else {
+            (void)s;
+            (void)g;
+            (void)bound;
+            return false;
+        }
+    }
+
+    bool search_below(State& s, cost_type g0, const move_type* parent,
+                      cost_type bound, cost_type& next, result_type& result,
+                      const std::atomic<bool>* stop) {
+        const cost_type f0 = g0 + heuristic_(s);
+        if (f0 > bound) {
+            if (f0 < next)
+                next = f0;
+            return false;
+        }
+        if (successors_.is_goal(s)) {
+            result.cost = g0;
+            return true;
+        }
+        if (transposed(s, g0, bound))
+            return false;
+
+        if (frames_.empty())
+            frames_.resize(1);
+        frames_[0].count = successors_.generate(s, parent, frames_[0].moves);
+        frames_[0].next = 0;
+        frames_[0].g = g0;
+        ++result.nodes_expanded;
+
+        std::size_t depth = 0;
+        for (;;) {
+            if (stop && stop->load(std::memory_order_relaxed)) {
+                for (std::size_t d = depth; d-- > 0;)
+                    successors_.undo(s, frames_[d].moves[frames_[d].next - 1]);
+                return false;
+            }
+
+            Frame& frame = frames_[depth];
+            if (frame.next == frame.count) {
+                if (depth == 0)
+                    return false;
+                --depth;
+                Frame& up = frames_[depth];
+                successors_.undo(s, up.moves[up.next - 1]);
+                continue;
+            }
+
+            const move_type move = frame.moves[frame.next++];
+            const cost_type g = frame.g + successors_.apply(s, move);
+            ++result.nodes_generated;
+
+            const cost_type f = g + heuristic_(s);
+            if (f > bound) {
+                if (f < next)
+                    next = f;
+                successors_.undo(s, move);
+                continue;
+            }
+
+            if (successors_.is_goal(s)) {
+                result.cost = g;
+                for (std::size_t d = 0; d <= depth; ++d)
+                    result.path.push_back(frames_[d].moves[frames_[d].next - 1]);
+                for (std::size_t d = depth + 1; d-- > 0;)
+                    successors_.undo(s, frames_[d].moves[frames_[d].next - 1]);
+                return true;
+            }
+
+            if (transposed(s, g, bound)) {
+                successors_.undo(s, move);
+                continue;
+            }
+
+            if (depth + 1 == frames_.size())
+                frames_.resize(frames_.size() * 2);
+            Frame& child = frames_[depth + 1];
+            child.count = successors_.generate(s, &move, child.moves);
+            child.next = 0;
+            child.g = g;
+            ++result.nodes_expanded;
+            ++depth;
+        }
+    }
+
+    Successors successors_;
+    Heuristic heuristic_;
+    Table* table_;
+    typename Table::counters_type counters_;
+    std::vector<Frame> frames_;
+};
+
+// Convenience wrapper for one-off searches.
+template <class State, class Successors, class Heuristic>
+Result<typename Successors::move_type, typename Successors::cost_type>
+solve(const State& root, Successors successors, Heuristic heuristic) {
+    Search<State, Successors, Heuristic> search(std::move(successors),
+                                                std::move(heuristic));
+    return search.solve(root);
+}
+
+}  // namespace ida
+
+#endif  // IDA_IDA_HPP
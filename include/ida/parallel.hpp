@@ -0,0 +1,348 @@
+// Multi-threaded IDA*.
+//
+// Every threshold iteration is split at a shallow frontier: the tree is
+// expanded depth-first, under the current threshold, down to a fixed depth,
+// and each surviving node becomes a task whose subtree is searched with the
+// sequential engine. Tasks are dealt out to per-thread queues; a thread that
+// runs dry steals half of another thread's remaining tasks. The threshold for
+// the next iteration is the minimum of the per-thread candidates, reduced
+// with a lock-free compare-and-swap loop.
+//
+// Every worker thread holds its own copy of the successor generator and the
+// heuristic, so both should be cheap to copy (heavy tables belong behind a
+// shared handle). A transposition table, if given, is shared by all workers.
+
+#ifndef IDA_PARALLEL_HPP
+#define IDA_PARALLEL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "ida.hpp"
+
+namespace ida {
+
+struct ParallelOptions {
+    // Number of worker threads, including the calling thread. Zero means
+    // std::thread::hardware_concurrency().
+    unsigned threads = 0;
+    // The frontier is deepened until it holds at least this many tasks per
+    // thread, or until max_frontier_depth is reached.
+    std::size_t tasks_per_thread = 64;
+    std::size_t max_frontier_depth = 24;
+};
+
+namespace detail {
+
+// Lowers `target` to `value` if `value` is smaller.
+template <class T>
+void atomic_fetch_min(std::atomic<T>& target, T value) {
+    T current = target.load(std::memory_order_relaxed);
+    while (value < current &&
+           !target.compare_exchange_weak(current, value,
+                                         std::memory_order_relaxed)) {
+    }
+}
+
+}  // namespace detail
+
+template <class State, class Successors, class Heuristic,
+          class Table = NoTable>
+class ParallelSearch {
+public:
+    using sequential_type = Search<State, Successors, Heuristic, Table>;
+    using state_type = State;
+    using move_type = typename sequential_type::move_type;
+    using cost_type = typename sequential_type::cost_type;
+    using result_type = typename sequential_type::result_type;
+
+    static constexpr cost_type infinity = sequential_type::infinity;
+
+    explicit ParallelSearch(Successors successors = Successors(),
+                            Heuristic heuristic = Heuristic(),
+                            ParallelOptions options = ParallelOptions(),
+                            Table* table = nullptr)
+        : successors_(std::move(successors)),
+          heuristic_(std::move(heuristic)),
+          options_(options),
+          table_(table) {
+        if (options_.threads == 0)
+            options_.threads = std::max(1u, std::thread::hardware_concurrency());
+        if (options_.max_frontier_depth == 0)
+            options_.max_frontier_depth = 1;
+    }
+
+    unsigned threads() const { return options_.threads; }
+
+    result_type solve(State root, cost_type max_bound = infinity) {
+        result_type result;
+        if (workers_.size() != options_.threads) {
+            workers_.clear();
+            for (unsigned i = 0; i < options_.threads; ++i)
+                workers_.emplace_back(
+                    new Worker(successors_, heuristic_, table_));
+        }
+        if constexpr (!std::is_same<Table, NoTable>::value)
+            if (table_)
+                table_->clear();
+
+        cost_type bound = heuristic_(root);
+        while (bound <= max_bound) {
+            ++result.iterations;
+            const auto before = detail::counters_of(result);
+            const auto start = std::chrono::steady_clock::now();
+            cost_type next = infinity;
+            const bool found = iterate(root, bound, next, result);
+            detail::record_iteration(result, bound, before, start);
+            if (found) {
+                result.found = true;
+                return result;
+            }
+            if (next == infinity)
+                break;
+            bound = next;
+        }
+        return result;
+    }
+
+private:
+    struct alignas(64) Worker {
+        Worker(const Successors& successors, const Heuristic& heuristic,
+               Table* table)
+            : search(successors, heuristic, table) {}
+
+        sequential_type search;
+        result_type stats;
+        std::mutex mutex;
+        std::vector<std::size_t> tasks;
+        std::size_t head = 0;
+    };
+
+    // Tasks of the current iteration: task i is reached from the root by
+    // moves[i * depth, (i + 1) * depth) at cost g[i].
+    struct Frontier {
+        std::size_t depth = 0;
+        std::vector<move_type> moves;
+        std::vector<cost_type> g;
+        std::vector<move_type> path;
+        result_type stats;
+    };
+
+    // Depth-first expansion of the root down to `frontier.depth`, pruned by
+    // `bound`. Returns true if a goal is met above the frontier, leaving its
+    // path in `frontier.path`.
+    bool expand_frontier(State& s, cost_type g, const move_type* parent,
+                         cost_type bound, cost_type& next, Frontier& frontier) {
+        const cost_type f = g + heuristic_(s);
+        if (f > bound) {
+            if (f < next)
+                next = f;
+            return false;
+        }
+        if (frontier.path.size() == frontier.depth) {
+            frontier.moves.insert(frontier.moves.end(), frontier.path.begin(),
+                                  frontier.path.end());
+            frontier.g.push_back(g);
+            return false;
+        }
+        if (successors_.is_goal(s)) {
+            frontier.stats.cost = g;
+            return true;
+        }
+
+        move_type moves[Successors::max_branching];
+        const std::size_t count = successors_.generate(s, parent, moves);
+        ++frontier.stats.nodes_expanded;
+        for (std::size_t i = 0; i < count; ++i) {
+            const cost_type step = successors_.apply(s, moves[i]);
+            ++frontier.stats.nodes_generated;
+            frontier.path.push_back(moves[i]);
+            const bool found = expand_frontier(s, g + step, &moves[i], bound,
+                                               next, frontier);
+            successors_.undo(s, moves[i]);
+            if (found)
+                return true;
+            frontier.path.pop_back();
+        }
+        return false;
+    }
+
+    bool take_task(std::size_t self, std::size_t& task) {
+        Worker& own = *workers_[self];
+        {
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (own.head < own.tasks.size()) {
+                task = own.tasks.back();
+                own.tasks.pop_back();
+                return true;
+            }
+        }
+
+        for (std::size_t i = 1; i < workers_.size(); ++i) {
+            Worker& victim = *workers_[(self + i) % workers_.size()];
+            std::vector<std::size_t> stolen;
+            {
+                std::lock_guard<std::mutex> lock(victim.mutex);
+                const std::size_t available = victim.tasks.size() - victim.head;
+                if (available == 0)
+                    continue;
+                const std::size_t n = (available + 1) / 2;
+                stolen.assign(victim.tasks.begin() + victim.head,
+                              victim.tasks.begin() + victim.head + n);
+                victim.head += n;
+            }
+            task = stolen.back();
+            stolen.pop_back();
+            if (!stolen.empty()) {
+                std::lock_guard<std::mutex> lock(own.mutex);
+                own.tasks.assign(stolen.begin(), stolen.end());
+                own.head = 0;
+            }
+            return true;
+        }
+        return false;
+    }
+
+    void run_worker(std::size_t self, const State& root, cost_type bound,
+                    const Frontier& frontier, std::atomic<cost_type>& next,
+                    std::atomic<bool>& stop, std::atomic<bool>& found,
+                    result_type& solution) {
+        Worker& worker = *workers_[self];
+        State s = root;
+        const std::size_t depth = frontier.depth;
+        cost_type local_next = infinity;
+        std::size_t task;
+        while (!stop.load(std::memory_order_relaxed) && take_task(self, task)) {
+            const move_type* prefix = frontier.moves.data() + task * depth;
+            for (std::size_t d = 0; d < depth; ++d)
+                successors_.apply(s, prefix[d]);
+
+            result_type& stats = worker.stats;
+            const std::size_t path_begin = stats.path.size();
+            if (worker.search.bounded_search(s, frontier.g[task],
+                                             &prefix[depth - 1], bound,
+                                             local_next, stats, &stop) &&
+                !found.exchange(true)) {
+                solution.cost = stats.cost;
+                solution.path.assign(prefix, prefix + depth);
+                solution.path.insert(solution.path.end(),
+                                     stats.path.begin() + path_begin,
+                                     stats.path.end());
+                stop.store(true, std::memory_order_relaxed);
+            }
+            stats.path.resize(path_begin);
+
+            for (std::size_t d = depth; d-- > 0;)
+                successors_.undo(s, prefix[d]);
+        }
+        detail::atomic_fetch_min(next, local_next);
+    }
+
+    bool iterate(State& root, cost_type bound, cost_type& next,
+                 result_type& result) {
+        const std::size_t threads = workers_.size();
+        const std::size_t wanted = options_.tasks_per_thread * threads;
+
+        Frontier frontier;
+        cost_type frontier_next;
+        for (std::size_t depth = 1;; ++depth) {
+            frontier.depth = depth;
+            frontier.moves.clear();
+            frontier.g.clear();
+            frontier.path.clear();
+            frontier_next = infinity;
+            if (expand_frontier(root, cost_type(0), nullptr, bound,
+                                frontier_next, frontier)) {
+                result.cost = frontier.stats.cost;
+                result.path = std::move(frontier.path);
+                accumulate(result, frontier.stats);
+                return true;
+            }
+            if (frontier.g.size() >= wanted || frontier.g.empty() ||
+                depth == options_.max_frontier_depth)
+                break;
+            // Only the final, deepest expansion counts towards the statistics.
+            frontier.stats = result_type();
+        }
+        accumulate(result, frontier.stats);
+
+        const std::size_t tasks = frontier.g.size();
+        if (tasks == 0) {
+            next = frontier_next;
+            return false;
+        }
+        for (std::size_t i = 0; i < threads; ++i) {
+            Worker& worker = *workers_[i];
+            worker.tasks.clear();
+            worker.head = 0;
+            worker.stats = result_type();
+            // Contiguous blocks, reversed so that each owner works through
+            // its block left to right while thieves take from the far end.
+            const std::size_t begin = tasks * i / threads;
+            const std::size_t end = tasks * (i + 1) / threads;
+            for (std::size_t t = end; t-- > begin;)
+                worker.tasks.push_back(t);
+        }
+
+        std::atomic<cost_type> shared_next(frontier_next);
+        std::atomic<bool> stop(false);
+        std::atomic<bool> found(false);
+        result_type solution;
+
+        std::vector<std::thread> pool;
+        try {
+            pool.reserve(threads - 1);
+            for (std::size_t i = 1; i < threads; ++i)
+                pool.emplace_back([&, i] {
+                    run_worker(i, root, bound, frontier, shared_next, stop,
+                               found, solution);
+                });
+        } catch (...) {
+            // Threads that did start must be joined before their shared
+            // state goes out of scope; a joinable std::thread would
+            // otherwise terminate the process on destruction.
+            stop.store(true, std::memory_order_relaxed);
+            for (std::thread& t : pool)
+                t.join();
+            throw;
+        }
+        run_worker(0, root, bound, frontier, shared_next, stop, found,
+                   solution);
+        for (std::thread& t : pool)
+            t.join();
+
+        for (const auto& worker : workers_)
+            accumulate(result, worker->stats);
+        if (found.load()) {
+            result.cost = solution.cost;
+            result.path = std::move(solution.path);
+            return true;
+        }
+        next = shared_next.load();
+        return false;
+    }
+
+    static void accumulate(result_type& total, const result_type& part) {
+        total.nodes_expanded += part.nodes_expanded;
+        total.nodes_generated += part.nodes_generated;
+    }
+
+    Successors successors_;
+    Heuristic heuristic_;
+    ParallelOptions options_;
+    Table* table_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+};
+
+}  // namespace ida
+
+#endif  // IDA_PARALLEL_HPP
@@ -0,0 +1,365 @@
+// Pattern databases (PDBs): heuristic tables indexed by an abstraction of the
+// state, built by a backward breadth-first search from the goal.
+//
+// An abstraction must provide:
+//
+//     std::uint64_t size() const;         // number of abstract states
+//     // Identifies the abstraction, including its goal, so that a table is
+//     // never used for a goal it was not built for.
+//     std::uint64_t fingerprint() const;
+//     std::uint64_t rank(const State&) const;
+//     std::uint64_t goal_rank() const;    // where the backward search starts
+//     // Calls f(predecessor_rank, cost) for every abstract predecessor of
+//     // `rank`, with cost 0 or 1. Zero-cost edges allow additive PDBs, which
+//     // only count the moves of pattern tiles.
+//     template <class F>
+//     void for_each_predecessor(std::uint64_t rank, F&& f) const;
+//     // A cheap lower bound on the abstract distance, such as the Manhattan
+//     // distance of the pattern tiles (or 0), by rank and by state.
+//     unsigned baseline_at(std::uint64_t rank) const;
+//     unsigned baseline(const State&) const;
+//
+// Entries store the distance minus the baseline, packed four bits apiece,
+// sixteen to a 64-bit word. Excesses that do not fit saturate at max_excess,
+// which keeps the table admissible. The search itself runs on a byte per
+// entry, so building needs about three times the memory of the result.
+//
+// On disk a PDB is a 64-byte header followed by the packed words, in native
+// byte order. load() maps the file read-only and shared, so opening even a
+// large table costs no copying and processes using the same file share its
+// pages. Loading is supported on POSIX systems.
+
+#ifndef IDA_PATTERN_DATABASE_HPP
+#define IDA_PATTERN_DATABASE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ida {
+
+class PatternDatabase {
+public:
+    static constexpr unsigned max_excess = 15;
+
+    PatternDatabase() = default;
+
+    PatternDatabase(PatternDatabase&& other) noexcept { swap(other); }
+
+    PatternDatabase& operator=(PatternDatabase&& other) noexcept {
+        PatternDatabase(std::move(other)).swap(*this);
+        return *this;
+    }
+
+    PatternDatabase(const PatternDatabase&) = delete;
+    PatternDatabase& operator=(const PatternDatabase&) = delete;
+
+    ~PatternDatabase() {
+        if (mapping_)
+            ::munmap(mapping_, mapping_bytes_);
+    }
+
+    // Runs the backward search from the abstraction's goal. Each
+    // level is one pass over the table, split into chunks that `threads`
+    // threads (0: one per hardware thread) claim dynamically. Zero-cost
+    // predecessors are closed over within the level by the thread that
+    // reached them.
+    template <class Abstraction>
+    static PatternDatabase build(const Abstraction& abstraction,
+                                 unsigned threads = 0) {
+        if (threads == 0)
+            threads = std::max(1u, std::thread::hardware_concurrency());
+
+        const std::uint64_t entries = abstraction.size();
+        const std::size_t distance_words =
+            static_cast<std::size_t>((entries + 7) / 8);
+        std::unique_ptr<std::atomic<std::uint64_t>[]> table(
+            new std::atomic<std::uint64_t>[distance_words]);
+        for (std::size_t w = 0; w < distance_words; ++w)
+            table[w].store(~std::uint64_t(0), std::memory_order_relaxed);
+        lower(table.get(), abstraction.goal_rank(), 0);
+
+        constexpr std::uint64_t chunk = 1 << 16;
+        for (unsigned level = 0; level + 1 < unreached; ++level) {
+            std::atomic<std::uint64_t> next_chunk(0);
+            std::atomic<bool> reached(false);
+            auto work = [&] {
+                std::vector<std::uint64_t> closure;
+                bool found_next = false;
+                for (;;) {
+                    const std::uint64_t begin =
+                        next_chunk.fetch_add(chunk, std::memory_order_relaxed);
+                    if (begin >= entries)
+                        break;
+                    const std::uint64_t end = std::min(begin + chunk, entries);
+                    for (std::uint64_t r = begin; r < end; ++r) {
+                        if (get(table.get(), r) != level)
+                            continue;
+                        closure.push_back(r);
+                        while (!closure.empty()) {
+                            const std::uint64_t x = closure.back();
+                            closure.pop_back();
+                            abstraction.for_each_predecessor(
+                                x, [&](std::uint64_t p, unsigned cost) {
+                                    if (cost == 0) {
+                                        if (lower(table.get(), p, level))
+                                            closure.push_back(p);
+                                    } else if (lower(table.get(), p,
+                                                     level + 1)) {
+                                        found_next = true;
+                                    }
+                                });
+                        }
+                    }
+                }
+                if (found_next)
+                    reached.store(true, std::memory_order_relaxed);
+            };
+
+            std::vector<std::thread> pool;
+            try {
+                pool.reserve(threads - 1);
+                for (unsigned t = 1; t < threads; ++t)
+                    pool.emplace_back(work);
+            } catch (...) {
+                // The threads that did start run until the chunks of this
+                // level are used up; joining them keeps the process alive.
+                for (std::thread& t : pool)
+                    t.join();
+                throw;
+            }
+            work();
+            for (std::thread& t : pool)
+                t.join();
+            if (!reached.load())
+                break;
+        }
+
+        PatternDatabase pdb;
+        pdb.owned_.assign(word_count(entries), 0);
+        for (std::uint64_t r = 0; r < entries; ++r) {
+            // Unreached entries are not abstractions of solvable states.
+            const unsigned distance = get(table.get(), r);
+            const unsigned base = abstraction.baseline_at(r);
+            if (distance < base)
+                throw std::invalid_argument(
+                    "abstraction baseline exceeds the abstract distance");
+            const unsigned excess =
+                distance == unreached ? max_excess
+                                      : std::min(distance - base, max_excess);
+            pdb.owned_[r >> 4] |= std::uint64_t(excess) << ((r & 15) * 4);
+        }
+        pdb.data_ = pdb.owned_.data();
+        pdb.entries_ = entries;
+        pdb.fingerprint_ = abstraction.fingerprint();
+        return pdb;
+    }
+
+    // Maps a file written by save(). Throws std::runtime_error if the file
+    // cannot be opened or is not a PDB in this machine's byte order.
+    static PatternDatabase load(const std::string& path) {
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw std::runtime_error("cannot open pattern database " + path);
+        struct stat st;
+        if (::fstat(fd, &st) != 0 ||
+            static_cast<std::uint64_t>(st.st_size) < sizeof(FileHeader)) {
+            ::close(fd);
+            throw std::runtime_error("truncated pattern database " + path);
+        }
+        const std::size_t bytes = static_cast<std::size_t>(st.st_size);
+        void* mapping = ::mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mapping == MAP_FAILED)
+            throw std::runtime_error("cannot map pattern database " + path);
+
+        PatternDatabase pdb;
+        pdb.mapping_ = mapping;
+        pdb.mapping_bytes_ = bytes;
+
+        FileHeader header;
+        std::memcpy(&header, mapping, sizeof(header));
+        if (std::memcmp(header.magic, file_magic, sizeof(header.magic)) != 0 ||
+            header.version != file_version ||
+            header.byte_order != file_byte_order)
+            throw std::runtime_error("not a compatible pattern database: " +
+                                     path);
+        // Bounding the entry count by the file size first keeps the size
+        // computation below from overflowing on a corrupt header.
+        if (header.entries > (bytes - sizeof(FileHeader)) / 8 * 16 ||
+            bytes != sizeof(FileHeader) + word_count(header.entries) * 8)
+            throw std::runtime_error("truncated pattern database " + path);
+
+        pdb.data_ = reinterpret_cast<const std::uint64_t*>(
+            static_cast<const char*>(mapping) + sizeof(FileHeader));
+        pdb.entries_ = header.entries;
+        pdb.fingerprint_ = header.fingerprint;
+        return pdb;
+    }
+
+    // Writes the table to `path`. The file is written under a unique
+    // temporary name in the same directory and renamed into place, so
+    // processes that have the old file mapped keep seeing consistent contents
+    // and concurrent saves of the same table do not clobber each other.
+    // Throws std::runtime_error on failure.
+    void save(const std::string& path) const {
+        FileHeader header = {};
+        std::memcpy(header.magic, file_magic, sizeof(header.magic));
+        header.version = file_version;
+        header.byte_order = file_byte_order;
+        header.entries = entries_;
+        header.fingerprint = fingerprint_;
+
+        std::string temporary = path + ".XXXXXX";
+        const int fd = ::mkstemp(&temporary[0]);
+        if (fd < 0)
+            throw std::runtime_error("cannot create pattern database " + path);
+        // mkstemp() creates the file private to its owner; the table is
+        // meant to be shared.
+        std::FILE* file =
+            ::fchmod(fd, 0644) == 0 ? ::fdopen(fd, "wb") : nullptr;
+        if (!file) {
+            ::close(fd);
+            std::remove(temporary.c_str());
+            throw std::runtime_error("cannot create pattern database " + path);
+        }
+        const std::size_t words = word_count(entries_);
+        const bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+                        std::fwrite(data_, 8, words, file) == words;
+        if (std::fclose(file) != 0 || !ok ||
+            std::rename(temporary.c_str(), path.c_str()) != 0) {
+            std::remove(temporary.c_str());
+            throw std::runtime_error("cannot write pattern database " + path);
+        }
+    }
+
+    std::uint64_t size() const { return entries_; }
+    std::uint64_t fingerprint() const { return fingerprint_; }
+    std::size_t memory_bytes() const { return word_count(entries_) * 8; }
+    bool mapped() const { return mapping_ != nullptr; }
+
+    // The stored excess over the abstraction's baseline.
+    unsigned operator[](std::uint64_t rank) const {
+        return static_cast<unsigned>(data_[rank >> 4] >> ((rank & 15) * 4)) &
+               15;
+    }
+
+    void swap(PatternDatabase& other) noexcept {
+        owned_.swap(other.owned_);
+        std::swap(data_, other.data_);
+        std::swap(entries_, other.entries_);
+        std::swap(fingerprint_, other.fingerprint_);
+        std::swap(mapping_, other.mapping_);
+        std::swap(mapping_bytes_, other.mapping_bytes_);
+    }
+
+private:
+    struct FileHeader {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t byte_order;
+        std::uint64_t entries;
+        std::uint64_t fingerprint;
+        std::uint64_t reserved[4];
+    };
+    static_assert(sizeof(FileHeader) == 64, "header must stay 64 bytes");
+
+    static constexpr char file_magic[8] = {'I', 'D', 'A', 'P', 'D', 'B', 0, 0};
+    static constexpr std::uint32_t file_version = 1;
+    static constexpr std::uint32_t file_byte_order = 0x01020304;
+
+    static std::size_t word_count(std::uint64_t entries) {
+        return static_cast<std::size_t>((entries + 15) / 16);
+    }
+
+    // Build-time distances are bytes, eight to an atomic word.
+    static constexpr unsigned unreached = 255;
+
+    static unsigned get(const std::atomic<std::uint64_t>* table,
+                        std::uint64_t rank) {
+        return static_cast<unsigned>(
+                   table[rank >> 3].load(std::memory_order_relaxed) >>
+                   ((rank & 7) * 8)) &
+               255;
+    }
+
+    // Lowers the distance at `rank` to `value`; returns false if it already
+    // held `value` or less.
+    static bool lower(std::atomic<std::uint64_t>* table, std::uint64_t rank,
+                      unsigned value) {
+        std::atomic<std::uint64_t>& word = table[rank >> 3];
+        const unsigned shift = (rank & 7) * 8;
+        std::uint64_t current = word.load(std::memory_order_relaxed);
+        for (;;) {
+            if (((current >> shift) & 255) <= value)
+                return false;
+            const std::uint64_t updated =
+                (current & ~(std::uint64_t(255) << shift)) |
+                (std::uint64_t(value) << shift);
+            if (word.compare_exchange_weak(current, updated,
+                                           std::memory_order_relaxed))
+                return true;
+        }
+    }
+
+    std::vector<std::uint64_t> owned_;
+    const std::uint64_t* data_ = nullptr;
+    std::uint64_t entries_ = 0;
+    std::uint64_t fingerprint_ = 0;
+    void* mapping_ = nullptr;
+    std::size_t mapping_bytes_ = 0;
+};
+
+// Heuristic that sums the values of several PDBs, each being the stored
+// excess plus the abstraction's baseline. The sum is admissible when
+// the abstractions count disjoint sets of moves, as with disjoint tile
+// patterns; with a single PDB it is just its value. Copies share the tables.
+template <class Abstraction>
+class PdbHeuristic {
+public:
+    // Throws std::invalid_argument if `pdb` was not built for `abstraction`.
+    void add(Abstraction abstraction,
+             std::shared_ptr<const PatternDatabase> pdb) {
+        if (!pdb || pdb->size() != abstraction.size() ||
+            pdb->fingerprint() != abstraction.fingerprint())
+            throw std::invalid_argument(
+                "pattern database does not match its abstraction");
+        parts_.push_back(Part{std::move(abstraction), std::move(pdb)});
+    }
+
+    template <class State>
+    int operator()(const State& s) const {
+        int h = 0;
+        for (const Part& part : parts_)
+            h += static_cast<int>((*part.pdb)[part.abstraction.rank(s)] +
+                                  part.abstraction.baseline(s));
+        return h;
+    }
+
+private:
+    struct Part {
+        Abstraction abstraction;
+        std::shared_ptr<const PatternDatabase> pdb;
+    };
+
+    std::vector<Part> parts_;
+};
+
+}  // namespace ida
+
+#endif  // IDA_PATTERN_DATABASE_HPP
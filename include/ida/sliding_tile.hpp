@@ -0,0 +1,339 @@
+// Sliding-tile puzzle domain (8-puzzle, 15-puzzle, ...) for the IDA* engine.
+//
+// Positions are numbered row-major. The goal places the blank at position 0
+// and tile i at position i, which matches the convention used by Korf's
+// 15-puzzle instances.
+
+#ifndef IDA_SLIDING_TILE_HPP
+#define IDA_SLIDING_TILE_HPP
+
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <stdexcept>
+#include <vector>
+
+namespace ida {
+
+template <int Width, int Height>
+class SlidingTile {
+public:
+    static_assert(Width >= 2 && Height >= 2, "puzzle must be at least 2x2");
+    static_assert(Width * Height <= 256, "tiles must fit in a byte");
+
+    static constexpr int width = Width;
+    static constexpr int height = Height;
+    static constexpr int size = Width * Height;
+
+    struct State {
+        std::array<std::uint8_t, size> tiles;
+        std::uint8_t blank;
+
+        friend bool operator==(const State& a, const State& b) {
+            return a.tiles == b.tiles;
+        }
+        friend bool operator!=(const State& a, const State& b) {
+            return !(a == b);
+        }
+    };
+
+    // Slides the tile at `to` into the blank at `from`.
+    struct Move {
+        std::uint8_t from;
+        std::uint8_t to;
+    };
+
+    using move_type = Move;
+    using cost_type = int;
+    static constexpr std::size_t max_branching = 4;
+
+    static State goal() {
+        State s;
+        for (int i = 0; i < size; ++i)
+            s.tiles[i] = static_cast<std::uint8_t>(i);
+        s.blank = 0;
+        return s;
+    }
+
+    // Builds a state from tile numbers by position, 0 being the blank.
+    // Throws std::invalid_argument unless `tiles` is a permutation of
+    // 0 .. size - 1.
+    static State from_tiles(const std::array<int, size>& tiles) {
+        State s;
+        bool seen[size] = {};
+        for (int i = 0; i < size; ++i) {
+            const int t = tiles[i];
+            if (t < 0 || t >= size || seen[t])
+                throw std::invalid_argument(
+                    "tiles must be a permutation of 0 .. size - 1");
+            seen[t] = true;
+            s.tiles[i] = static_cast<std::uint8_t>(t);
+            if (t == 0)
+                s.blank = static_cast<std::uint8_t>(i);
+        }
+        return s;
+    }
+
+    // A state is solvable iff its permutation parity, adjusted for the blank
+    // row on even-width boards, matches that of the goal.
+    static bool solvable(const State& s) {
+        int inversions = 0;
+        for (int i = 0; i < size; ++i)
+            for (int j = i + 1; j < size; ++j)
+                if (s.tiles[i] && s.tiles[j] && s.tiles[i] > s.tiles[j])
+                    ++inversions;
+        if (Width % 2 == 1)
+            return inversions % 2 == 0;
+        return (inversions + s.blank / Width) % 2 == 0;
+    }
+
+    // Packs the board four bits per tile. This is injective, as a
+    // transposition table requires, only for boards of up to 16 cells, so
+    // larger boards do not provide a hash.
+    std::uint64_t hash(const State& s) const {
+        static_assert(size <= 16,
+                      "boards over 16 cells have no exact 64-bit hash");
+        std::uint64_t h = 0;
+        for (int i = 0; i < size; ++i)
+            h = (h << 4) | s.tiles[i];
+        // splitmix64 finaliser: a bijection, so the key stays exact while its
+        // low bits index buckets evenly.
+        h ^= h >> 30;
+        h *= 0xbf58476d1ce4e5b9ull;
+        h ^= h >> 27;
+        h *= 0x94d049bb133111ebull;
+        h ^= h >> 31;
+        return h;
+    }
+
+    bool is_goal(const State& s) const {
+        for (int i = 0; i < size; ++i)
+            if (s.tiles[i] != i)
+                return false;
+        return true;
+    }
+
+    std::size_t generate(const State& s, const Move* parent, Move* out) const {
+        const int b = s.blank;
+        const int back = parent ? parent->from : -1;
+        std::size_t n = 0;
+        auto push = [&](int to) {
+            if (to != back)
+                out[n++] = Move{static_cast<std::uint8_t>(b),
+                                static_cast<std::uint8_t>(to)};
+        };
+        if (b >= Width)
+            push(b - Width);
+        if (b % Width != 0)
+            push(b - 1);
+        if (b % Width != Width - 1)
+            push(b + 1);
+        if (b < size - Width)
+            push(b + Width);
+        return n;
+    }
+
+    cost_type apply(State& s, const Move& m) const {
+        s.tiles[m.from] = s.tiles[m.to];
+        s.tiles[m.to] = 0;
+        s.blank = m.to;
+        return 1;
+    }
+
+    void undo(State& s, const Move& m) const {
+        s.tiles[m.to] = s.tiles[m.from];
+        s.tiles[m.from] = 0;
+        s.blank = m.from;
+    }
+};
+
+// Sum of Manhattan distances of all tiles to their goal positions.
+template <int Width, int Height>
+class Manhattan {
+public:
+    using domain_type = SlidingTile<Width, Height>;
+    using state_type = typename domain_type::State;
+    static constexpr int size = domain_type::size;
+
+    Manhattan() {
+        for (int tile = 0; tile < size; ++tile)
+            for (int pos = 0; pos < size; ++pos)
+                distance_[tile][pos] =
+                    tile == 0 ? 0
+                              : static_cast<std::uint8_t>(
+                                    std::abs(tile / Width - pos / Width) +
+                                    std::abs(tile % Width - pos % Width));
+    }
+
+    int operator()(const state_type& s) const {
+        int h = 0;
+        for (int pos = 0; pos < size; ++pos)
+            h += distance_[s.tiles[pos]][pos];
+        return h;
+    }
+
+private:
+    std::uint8_t distance_[size][size];
+};
+
+// Pattern abstraction for pattern databases (see pattern_database.hpp). An
+// abstract state is the position of the blank followed by the positions of
+// the pattern tiles, ranked as a partial permutation. Only moves of pattern
+// tiles cost 1, so disjoint patterns can be added. The baseline is the
+// Manhattan distance of the pattern tiles.
+template <int Width, int Height>
+class TilePattern {
+public:
+    using domain_type = SlidingTile<Width, Height>;
+    using state_type = typename domain_type::State;
+    static constexpr int cells = domain_type::size;
+    static_assert(cells <= 32, "positions are tracked in a 32-bit mask");
+
+    // Throws std::invalid_argument unless `tiles` are distinct, non-blank
+    // tiles of the puzzle.
+    explicit TilePattern(std::vector<int> tiles) : tiles_(std::move(tiles)) {
+        slot_.fill(-1);
+        if (tiles_.empty() || static_cast<int>(tiles_.size()) >= cells - 1)
+            throw std::invalid_argument("bad tile pattern size");
+        for (std::size_t i = 0; i < tiles_.size(); ++i) {
+            const int t = tiles_[i];
+            if (t <= 0 || t >= cells || slot_[t] != -1)
+                throw std::invalid_argument("bad tile in pattern");
+            slot_[t] = static_cast<std::int8_t>(i + 1);
+        }
+        for (int tile = 0; tile < cells; ++tile)
+            for (int pos = 0; pos < cells; ++pos)
+                distance_[tile][pos] =
+                    slot_[tile] == -1
+                        ? 0
+                        : static_cast<std::uint8_t>(
+                              std::abs(tile / Width - pos / Width) +
+                              std::abs(tile % Width - pos % Width));
+        size_ = 1;
+        for (int i = 0; i <= pattern_size(); ++i)
+            size_ *= static_cast<std::uint64_t>(cells - i);
+    }
+
+    const std::vector<int>& tiles() const { return tiles_; }
+    int pattern_size() const { return static_cast<int>(tiles_.size()); }
+    std::uint64_t size() const { return size_; }
+
+    // The goal is always domain_type::goal(), which the baseline assumes,
+    // so the tiles and board size identify the abstraction.
+    std::uint64_t fingerprint() const {
+        auto mix = [](std::uint64_t h, int v) {
+            return (h ^ static_cast<std::uint64_t>(v)) * 0x100000001b3ull;
+        };
+        std::uint64_t h = mix(mix(0xcbf29ce484222325ull, Width), Height);
+        for (int t : tiles_)
+            h = mix(h, t);
+        return h;
+    }
+
+    std::uint64_t rank(const state_type& s) const {
+        std::uint8_t pos[cells];
+        pos[0] = s.blank;
+        for (int p = 0; p < cells; ++p) {
+            const int slot = slot_[s.tiles[p]];
+            if (slot > 0)
+                pos[slot] = static_cast<std::uint8_t>(p);
+        }
+        return rank_positions(pos);
+    }
+
+    std::uint64_t goal_rank() const { return rank(domain_type::goal()); }
+
+    unsigned baseline(const state_type& s) const {
+        unsigned h = 0;
+        for (int p = 0; p < cells; ++p)
+            h += distance_[s.tiles[p]][p];
+        return h;
+    }
+
+    unsigned baseline_at(std::uint64_t r) const {
+        std::uint8_t pos[cells] = {};
+        unrank_positions(r, pos);
+        unsigned h = 0;
+        for (int i = 1; i <= pattern_size(); ++i)
+            h += distance_[tiles_[i - 1]][pos[i]];
+        return h;
+    }
+
+    // Moves are reversible, so predecessors are the neighbours by one move.
+    template <class F>
+    void for_each_predecessor(std::uint64_t r, F&& f) const {
+        std::uint8_t pos[cells] = {};
+        unrank_positions(r, pos);
+        const int b = pos[0];
+        auto visit = [&](int to) {
+            int moved = 0;
+            for (int i = 1; i <= pattern_size(); ++i)
+                if (pos[i] == to)
+                    moved = i;
+            pos[0] = static_cast<std::uint8_t>(to);
+            if (moved)
+                pos[moved] = static_cast<std::uint8_t>(b);
+            f(rank_positions(pos), moved ? 1u : 0u);
+            if (moved)
+                pos[moved] = static_cast<std::uint8_t>(to);
+            pos[0] = static_cast<std::uint8_t>(b);
+        };
+        if (b >= Width)
+            visit(b - Width);
+        if (b % Width != 0)
+            visit(b - 1);
+        if (b % Width != Width - 1)
+            visit(b + 1);
+        if (b < cells - Width)
+            visit(b + Width);
+    }
+
+private:
+    // Each position is numbered among the cells not taken by the earlier
+    // ones, giving a mixed-radix number with radices cells, cells - 1, ...
+    std::uint64_t rank_positions(const std::uint8_t* pos) const {
+        std::uint32_t used = 0;
+        std::uint64_t r = 0;
+        for (int i = 0; i <= pattern_size(); ++i) {
+            const std::uint32_t below = used & ((1u << pos[i]) - 1);
+            r = r * static_cast<std::uint64_t>(cells - i) + pos[i] -
+                std::bitset<32>(below).count();
+            used |= 1u << pos[i];
+        }
+        return r;
+    }
+
+    void unrank_positions(std::uint64_t r, std::uint8_t* pos) const {
+        std::uint8_t digits[cells];
+        for (int i = pattern_size(); i >= 0; --i) {
+            digits[i] = static_cast<std::uint8_t>(r % (cells - i));
+            r /= static_cast<std::uint64_t>(cells - i);
+        }
+        std::uint32_t used = 0;
+        for (int i = 0; i <= pattern_size(); ++i) {
+            int p = 0;
+            for (int free = digits[i];; ++p)
+                if (!(used & (1u << p)) && free-- == 0)
+                    break;
+            pos[i] = static_cast<std::uint8_t>(p);
+            used |= 1u << p;
+        }
+    }
+
+    std::vector<int> tiles_;
+    // slot_[tile] is the tile's index in the abstract state, -1 if the tile
+    // is not in the pattern.
+    std::array<std::int8_t, cells> slot_;
+    // Manhattan distances of pattern tiles; zero for all other tiles.
+    std::uint8_t distance_[cells][cells];
+    std::uint64_t size_;
+};
+
+using EightPuzzle = SlidingTile<3, 3>;
+using FifteenPuzzle = SlidingTile<4, 4>;
+
+}  // namespace ida
+
+#endif  // IDA_SLIDING_TILE_HPP
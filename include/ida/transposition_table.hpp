@@ -0,0 +1,180 @@
+// Fixed-size transposition table for IDA*.
+//
+// The table remembers, per hashed state, the smallest g-value it was reached
+// with and the threshold of the iteration in which that happened. A node is
+// cut off when the table shows the same state reached more cheaply, or at
+// the same cost within the current (or a later) threshold; in both cases its
+// subtree is, or has already been, searched from the other path. This relies
+// on strictly positive step costs and a consistent heuristic.
+//
+// Entries are grouped four to a 64-byte bucket, so a probe touches a single
+// cache line. Each entry is a pair of 64-bit words, the packed data and the
+// key xor-ed with the data; a reader that observes a half-written entry sees
+// a mismatching key and treats it as absent. The table can therefore be
+// shared by the threads of a ParallelSearch without locking.
+//
+// When the probed bucket is full, the entry with the smallest threshold
+// (the stalest iteration) is replaced, and among those the one with the
+// largest g-value, whose subtree is the cheapest to search again.
+
+#ifndef IDA_TRANSPOSITION_TABLE_HPP
+#define IDA_TRANSPOSITION_TABLE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+
+namespace ida {
+
+struct TableCounters {
+    std::uint64_t hits = 0;          // probes that found the state
+    std::uint64_t misses = 0;        // probes that did not
+    std::uint64_t cutoffs = 0;       // hits that pruned the node
+    std::uint64_t replacements = 0;  // misses that evicted another state
+};
+
+class TranspositionTable {
+public:
+    using counters_type = TableCounters;
+
+    static constexpr std::size_t bucket_bytes = 64;
+    static constexpr std::size_t entries_per_bucket = 4;
+
+    // Allocates the largest power-of-two number of buckets that fits in
+    // `max_bytes`.
+    explicit TranspositionTable(std::size_t max_bytes) {
+        if (max_bytes < bucket_bytes)
+            throw std::invalid_argument(
+                "transposition table needs at least one 64-byte bucket");
+        std::size_t buckets = 1;
+        while (buckets * 2 <= max_bytes / bucket_bytes)
+            buckets *= 2;
+        buckets_.reset(new Bucket[buckets]);
+        mask_ = buckets - 1;
+    }
+
+    std::size_t capacity() const { return (mask_ + 1) * entries_per_bucket; }
+    std::size_t memory_bytes() const { return (mask_ + 1) * bucket_bytes; }
+
+    // Forgets all entries. Must be called before searching from a different
+    // root, since stored g-values are relative to the root. Not thread-safe.
+    void clear() {
+        for (std::size_t b = 0; b <= mask_; ++b)
+            for (Entry& e : buckets_[b].entries) {
+                e.data.store(0, std::memory_order_relaxed);
+                e.check.store(0, std::memory_order_relaxed);
+            }
+    }
+
+    // Records a visit to the state with hash `key` at cost `g` under the
+    // iteration threshold `bound`, which must be below UINT32_MAX. Returns
+    // true if the node can be pruned.
+    bool visit(std::uint64_t key, std::uint32_t g, std::uint32_t bound,
+               TableCounters& counters) {
+        Bucket& bucket = buckets_[key & mask_];
+        Entry* victim = nullptr;
+        std::uint64_t victim_data = 0;
+        for (Entry& e : bucket.entries) {
+            const std::uint64_t data = e.data.load(std::memory_order_relaxed);
+            const std::uint64_t check = e.check.load(std::memory_order_relaxed);
+            if (data != 0 && (check ^ data) == key) {
+                ++counters.hits;
+                const std::uint32_t stored_g = entry_g(data);
+                if (stored_g < g ||
+                    (stored_g == g && entry_bound(data) >= bound)) {
+                    ++counters.cutoffs;
+                    return true;
+                }
+                store(e, key, g, bound);
+                return false;
+            }
+            if (!victim ||
+                (victim_data != 0 && evicts_before(data, victim_data))) {
+                victim = &e;
+                victim_data = data;
+            }
+        }
+        ++counters.misses;
+        if (victim_data != 0)
+            ++counters.replacements;
+        store(*victim, key, g, bound);
+        return false;
+    }
+
+    // Adds a searcher's local counters to the table-wide totals.
+    void record(const TableCounters& c) {
+        hits_.fetch_add(c.hits, std::memory_order_relaxed);
+        misses_.fetch_add(c.misses, std::memory_order_relaxed);
+        cutoffs_.fetch_add(c.cutoffs, std::memory_order_relaxed);
+        replacements_.fetch_add(c.replacements, std::memory_order_relaxed);
+    }
+
+    TableCounters counters() const {
+        TableCounters c;
+        c.hits = hits_.load(std::memory_order_relaxed);
+        c.misses = misses_.load(std::memory_order_relaxed);
+        c.cutoffs = cutoffs_.load(std::memory_order_relaxed);
+        c.replacements = replacements_.load(std::memory_order_relaxed);
+        return c;
+    }
+
+    void reset_counters() {
+        hits_.store(0, std::memory_order_relaxed);
+        misses_.store(0, std::memory_order_relaxed);
+        cutoffs_.store(0, std::memory_order_relaxed);
+        replacements_.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    // data: g in the high half, bound + 1 in the low half; 0 marks an empty
+    // entry.
+    struct Entry {
+        std::atomic<std::uint64_t> check{0};
+        std::atomic<std::uint64_t> data{0};
+    };
+
+    struct alignas(bucket_bytes) Bucket {
+        Entry entries[entries_per_bucket];
+    };
+    static_assert(sizeof(Bucket) == bucket_bytes,
+                  "bucket must fill a cache line");
+
+    static std::uint32_t entry_g(std::uint64_t data) {
+        return static_cast<std::uint32_t>(data >> 32);
+    }
+    static std::uint32_t entry_bound(std::uint64_t data) {
+        return static_cast<std::uint32_t>(data) - 1;
+    }
+
+    // Empty entries go first, then stale thresholds, then deep nodes.
+    static bool evicts_before(std::uint64_t a, std::uint64_t b) {
+        if (a == 0)
+            return true;
+        if (entry_bound(a) != entry_bound(b))
+            return entry_bound(a) < entry_bound(b);
+        return entry_g(a) > entry_g(b);
+    }
+
+    static void store(Entry& e, std::uint64_t key, std::uint32_t g,
+                      std::uint32_t bound) {
+        const std::uint64_t data =
+            (static_cast<std::uint64_t>(g) << 32) |
+            (static_cast<std::uint64_t>(bound) + 1);
+        e.data.store(data, std::memory_order_relaxed);
+        e.check.store(key ^ data, std::memory_order_relaxed);
+    }
+
+    std::unique_ptr<Bucket[]> buckets_;
+    std::size_t mask_ = 0;
+
+    std::atomic<std::uint64_t> hits_{0};
+    std::atomic<std::uint64_t> misses_{0};
+    std::atomic<std::uint64_t> cutoffs_{0};
+    std::atomic<std::uint64_t> replacements_{0};
+};
+
+}  // namespace ida
+
+#endif  // IDA_TRANSPOSITION_TABLE_HPP
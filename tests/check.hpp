@@ -0,0 +1,88 @@
+// Minimal assertion helpers shared by the tests.
+
+#ifndef IDA_TESTS_CHECK_HPP
+#define IDA_TESTS_CHECK_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <vector>
+
+namespace ida_test {
+
+inline int& failures() {
+    static int count = 0;
+    return count;
+}
+
+inline int report(const char* name) {
+    if (failures() == 0)
+        std::printf("%s: all checks passed\n", name);
+    return failures() == 0 ? 0 : 1;
+}
+
+// Replays `path` from `s`, checking that every move is one the generator
+// offers (moves are compared bytewise), that the step costs add up to `cost`
+// and that the end is a goal.
+template <class Successors, class State, class Move, class Cost>
+bool valid_path(const Successors& successors, State s,
+                const std::vector<Move>& path, Cost cost) {
+    Cost total = 0;
+    const Move* parent = nullptr;
+    for (const Move& m : path) {
+        Move moves[Successors::max_branching];
+        const std::size_t n = successors.generate(s, parent, moves);
+        if (std::none_of(moves, moves + n, [&](const Move& x) {
+                return std::equal(reinterpret_cast<const char*>(&x),
+                                  reinterpret_cast<const char*>(&x + 1),
+                                  reinterpret_cast<const char*>(&m));
+            }))
+            return false;
+        total += successors.apply(s, m);
+        parent = &m;
+    }
+    return total == cost && successors.is_goal(s);
+}
+
+// Walks `length` random moves from `s` without immediate reversals.
+template <class Successors, class State, class Rng>
+State random_walk(const Successors& successors, State s, int length,
+                  Rng& rng) {
+    typename Successors::move_type moves[Successors::max_branching];
+    typename Successors::move_type last{};
+    for (int i = 0; i < length; ++i) {
+        const std::size_t n =
+            successors.generate(s, i ? &last : nullptr, moves);
+        last = moves[rng() % n];
+        successors.apply(s, last);
+    }
+    return s;
+}
+
+}  // namespace ida_test
+
+#define CHECK(condition)                                                 \
+    do {                                                                 \
+        if (!(condition)) {                                              \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__,  \
+                         __LINE__, #condition);                          \
+            ++ida_test::failures();                                      \
+        }                                                                \
+    } while (0)
+
+#define CHECK_THROWS(expression, exception)                              \
+    do {                                                                 \
+        bool thrown = false;                                             \
+        try {                                                            \
+            (void)(expression);                                          \
+        } catch (const exception&) {                                     \
+            thrown = true;                                               \
+        }                                                                \
+        if (!thrown) {                                                   \
+            std::fprintf(stderr, "%s:%d: expected %s from %s\n",         \
+                         __FILE__, __LINE__, #exception, #expression);   \
+            ++ida_test::failures();                                      \
+        }                                                                \
+    } while (0)
+
+#endif  // IDA_TESTS_CHECK_HPP
@@ -0,0 +1,97 @@
+#include <ida/ida.hpp>
+#include <ida/parallel.hpp>
+#include <ida/sliding_tile.hpp>
+
+#include <cstddef>
+#include <random>
+
+#include "check.hpp"
+
+namespace {
+
+using Eight = ida::EightPuzzle;
+using Fifteen = ida::FifteenPuzzle;
+
+// Solves random walks from the goal with the sequential engine and with the
+// parallel one under `options`, which must agree on the optimal cost.
+template <class Puzzle, class Heuristic>
+void compare(ida::ParallelOptions options, int instances, int walk,
+             unsigned seed) {
+    const Puzzle puzzle;
+    ida::Search<typename Puzzle::State, Puzzle, Heuristic> sequential;
+    ida::ParallelSearch<typename Puzzle::State, Puzzle, Heuristic> parallel(
+        puzzle, Heuristic(), options);
+    CHECK(parallel.threads() == options.threads);
+
+    std::mt19937 rng(seed);
+    for (int i = 0; i < instances; ++i) {
+        const auto s = ida_test::random_walk(puzzle, Puzzle::goal(), walk, rng);
+        const auto expected = sequential.solve(s);
+        const auto r = parallel.solve(s);
+        CHECK(r.found);
+        CHECK(r.cost == expected.cost);
+        CHECK(r.iterations == expected.iterations);
+        CHECK(r.per_iteration.size() == r.iterations);
+        CHECK(ida_test::valid_path(puzzle, s, r.path, r.cost));
+    }
+}
+
+void test_thread_counts() {
+    for (unsigned threads : {1u, 2u, 3u, 8u}) {
+        ida::ParallelOptions options;
+        options.threads = threads;
+        compare<Eight, ida::Manhattan<3, 3>>(options, 20, 40, threads);
+        compare<Fifteen, ida::Manhattan<4, 4>>(options, 5, 50, threads);
+    }
+}
+
+// More threads than there are frontier tasks, so that most workers find
+// nothing to take or steal.
+void test_more_threads_than_tasks() {
+    ida::ParallelOptions options;
+    options.threads = 16;
+    options.tasks_per_thread = 1;
+    options.max_frontier_depth = 1;
+    compare<Eight, ida::Manhattan<3, 3>>(options, 20, 40, 7);
+    compare<Fifteen, ida::Manhattan<4, 4>>(options, 5, 50, 7);
+}
+
+void test_shallow_frontier() {
+    for (unsigned threads : {1u, 4u}) {
+        ida::ParallelOptions options;
+        options.threads = threads;
+        options.max_frontier_depth = 1;
+        compare<Eight, ida::Manhattan<3, 3>>(options, 20, 40, 11);
+    }
+}
+
+void test_goal_above_frontier() {
+    // Solutions shorter than the frontier depth are found while it is being
+    // expanded, before any task runs.
+    const Eight puzzle;
+    ida::ParallelOptions options;
+    options.threads = 4;
+    options.tasks_per_thread = 1 << 20;
+    ida::ParallelSearch<Eight::State, Eight, ida::Manhattan<3, 3>> parallel(
+        puzzle, ida::Manhattan<3, 3>(), options);
+
+    std::mt19937 rng(3);
+    for (int walk = 0; walk < 6; ++walk) {
+        const Eight::State s =
+            ida_test::random_walk(puzzle, Eight::goal(), walk, rng);
+        const auto r = parallel.solve(s);
+        CHECK(r.found);
+        CHECK(r.cost <= walk);
+        CHECK(ida_test::valid_path(puzzle, s, r.path, r.cost));
+    }
+}
+
+}  // namespace
+
+int main() {
+    test_thread_counts();
+    test_more_threads_than_tasks();
+    test_shallow_frontier();
+    test_goal_above_frontier();
+    return ida_test::report("parallel_test");
+}
@@ -0,0 +1,191 @@
+#include <ida/ida.hpp>
+#include <ida/pattern_database.hpp>
+#include <ida/sliding_tile.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "check.hpp"
+
+namespace {
+
+using Eight = ida::EightPuzzle;
+using Pattern = ida::TilePattern<3, 3>;
+
+std::string temporary_path(const char* name) {
+    return "/tmp/ida_pattern_database_test_" + std::to_string(::getpid()) +
+           "_" + name;
+}
+
+std::string read_file(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in),
+                       std::istreambuf_iterator<char>());
+}
+
+void write_file(const std::string& path, const std::string& contents) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+}
+
+void test_round_trip() {
+    const Pattern pattern({1, 2, 3});
+    const auto built = ida::PatternDatabase::build(pattern, 2);
+    CHECK(built.size() == pattern.size());
+    CHECK(built.fingerprint() == pattern.fingerprint());
+    CHECK(!built.mapped());
+    CHECK(pattern.goal_rank() == pattern.rank(Eight::goal()));
+    // The goal is at distance zero.
+    CHECK(built[pattern.rank(Eight::goal())] == 0);
+
+    const std::string path = temporary_path("round_trip.pdb");
+    const std::string copy = temporary_path("round_trip_copy.pdb");
+    built.save(path);
+    {
+        const auto loaded = ida::PatternDatabase::load(path);
+        CHECK(loaded.mapped());
+        CHECK(loaded.size() == built.size());
+        CHECK(loaded.fingerprint() == built.fingerprint());
+        CHECK(loaded.memory_bytes() == built.memory_bytes());
+        bool same = true;
+        for (std::uint64_t r = 0; r < built.size(); ++r)
+            same = same && loaded[r] == built[r];
+        CHECK(same);
+        loaded.save(copy);
+    }
+    const std::string bytes = read_file(path);
+    CHECK(bytes.size() == 64 + built.memory_bytes());
+    CHECK(read_file(copy) == bytes);
+
+    // Builds are deterministic whatever the thread count.
+    ida::PatternDatabase::build(pattern, 1).save(copy);
+    CHECK(read_file(copy) == bytes);
+
+    std::remove(path.c_str());
+    std::remove(copy.c_str());
+}
+
+// Processes sharing a PDB cache may save the same table at once; every save
+// must succeed and leave a complete file behind.
+void test_concurrent_saves() {
+    const Pattern pattern({1, 2, 3});
+    const auto pdb = ida::PatternDatabase::build(pattern, 1);
+    const std::string path = temporary_path("concurrent.pdb");
+
+    std::atomic<int> failures(0);
+    std::vector<std::thread> savers;
+    for (int i = 0; i < 8; ++i)
+        savers.emplace_back([&] {
+            for (int k = 0; k < 20; ++k) {
+                try {
+                    pdb.save(path);
+                } catch (const std::runtime_error&) {
+                    ++failures;
+                }
+            }
+        });
+    for (std::thread& t : savers)
+        t.join();
+    CHECK(failures.load() == 0);
+
+    const auto loaded = ida::PatternDatabase::load(path);
+    CHECK(loaded.size() == pdb.size());
+    CHECK(loaded.fingerprint() == pdb.fingerprint());
+    std::remove(path.c_str());
+}
+
+void test_bad_files() {
+    const Pattern pattern({1, 2, 3});
+    const std::string path = temporary_path("good.pdb");
+    const std::string bad = temporary_path("bad.pdb");
+    ida::PatternDatabase::build(pattern, 1).save(path);
+    const std::string bytes = read_file(path);
+
+    CHECK_THROWS(ida::PatternDatabase::load(temporary_path("missing.pdb")),
+                 std::runtime_error);
+
+    write_file(bad, bytes.substr(0, 32));
+    CHECK_THROWS(ida::PatternDatabase::load(bad), std::runtime_error);
+
+    write_file(bad, bytes.substr(0, bytes.size() - 8));
+    CHECK_THROWS(ida::PatternDatabase::load(bad), std::runtime_error);
+
+    write_file(bad, bytes + std::string(8, '\0'));
+    CHECK_THROWS(ida::PatternDatabase::load(bad), std::runtime_error);
+
+    std::string corrupt = bytes;
+    corrupt[0] = 'X';
+    write_file(bad, corrupt);
+    CHECK_THROWS(ida::PatternDatabase::load(bad), std::runtime_error);
+
+    // A header-only file whose entry count wraps around to zero words when
+    // rounded up must not pass.
+    corrupt = bytes.substr(0, 64);
+    const std::uint64_t entries = ~std::uint64_t(0);
+    corrupt.replace(16, 8, reinterpret_cast<const char*>(&entries), 8);
+    write_file(bad, corrupt);
+    CHECK_THROWS(ida::PatternDatabase::load(bad), std::runtime_error);
+
+    // A table built for another pattern is refused by the heuristic.
+    ida::PdbHeuristic<Pattern> heuristic;
+    auto pdb = std::make_shared<const ida::PatternDatabase>(
+        ida::PatternDatabase::load(path));
+    CHECK_THROWS(heuristic.add(Pattern({1, 2, 4}), pdb),
+                 std::invalid_argument);
+    heuristic.add(pattern, pdb);
+
+    std::remove(path.c_str());
+    std::remove(bad.c_str());
+}
+
+// Additive PDBs are admissible: IDA* with them finds the same optimal costs
+// as with the Manhattan distance, which they dominate at the root.
+void test_search() {
+    ida::PdbHeuristic<Pattern> pdbs;
+    for (const std::vector<int>& tiles : {std::vector<int>{1, 2, 3, 4},
+                                          std::vector<int>{5, 6, 7, 8}}) {
+        const Pattern pattern(tiles);
+        pdbs.add(pattern,
+                 std::make_shared<const ida::PatternDatabase>(
+                     ida::PatternDatabase::build(pattern, 2)));
+    }
+
+    const Eight puzzle;
+    const ida::Manhattan<3, 3> manhattan;
+    ida::Search<Eight::State, Eight, ida::PdbHeuristic<Pattern>> search(
+        puzzle, pdbs);
+    ida::Search<Eight::State, Eight, ida::Manhattan<3, 3>> reference;
+    std::mt19937 rng(9);
+    for (int i = 0; i < 30; ++i) {
+        const Eight::State s =
+            ida_test::random_walk(puzzle, Eight::goal(), 30 + i, rng);
+        CHECK(pdbs(s) >= manhattan(s));
+        const auto expected = reference.solve(s);
+        const auto r = search.solve(s);
+        CHECK(r.found);
+        CHECK(r.cost == expected.cost);
+        CHECK(pdbs(s) <= r.cost);
+        CHECK(ida_test::valid_path(puzzle, s, r.path, r.cost));
+    }
+}
+
+}  // namespace
+
+int main() {
+    test_round_trip();
+    test_concurrent_saves();
+    test_bad_files();
+    test_search();
+    return ida_test::report("pattern_database_test");
+}
@@ -0,0 +1,130 @@
+#include <ida/ida.hpp>
+#include <ida/sliding_tile.hpp>
+
+#include <array>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include "check.hpp"
+
+namespace {
+
+using Eight = ida::EightPuzzle;
+using Fifteen = ida::FifteenPuzzle;
+
+// Exact distances to the goal of every reachable 8-puzzle state.
+std::unordered_map<std::uint64_t, int> eight_puzzle_distances() {
+    const Eight puzzle;
+    std::unordered_map<std::uint64_t, int> distance;
+    std::vector<Eight::State> frontier{Eight::goal()};
+    distance[puzzle.hash(Eight::goal())] = 0;
+    for (int d = 0; !frontier.empty(); ++d) {
+        std::vector<Eight::State> next;
+        for (Eight::State& s : frontier) {
+            Eight::Move moves[Eight::max_branching];
+            const std::size_t n = puzzle.generate(s, nullptr, moves);
+            for (std::size_t i = 0; i < n; ++i) {
+                puzzle.apply(s, moves[i]);
+                if (distance.emplace(puzzle.hash(s), d + 1).second)
+                    next.push_back(s);
+                puzzle.undo(s, moves[i]);
+            }
+        }
+        frontier.swap(next);
+    }
+    return distance;
+}
+
+void test_domain() {
+    const Fifteen puzzle;
+    Fifteen::State s = Fifteen::goal();
+    CHECK(puzzle.is_goal(s));
+    CHECK(Fifteen::solvable(s));
+
+    Fifteen::Move moves[Fifteen::max_branching];
+    CHECK(puzzle.generate(s, nullptr, moves) == 2);
+    puzzle.apply(s, moves[0]);
+    CHECK(!puzzle.is_goal(s));
+    CHECK(Fifteen::solvable(s));
+    puzzle.undo(s, moves[0]);
+    CHECK(s == Fifteen::goal());
+
+    // Swapping two tiles flips the permutation parity.
+    CHECK(!Fifteen::solvable(Fifteen::from_tiles(
+        {0, 2, 1, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15})));
+    CHECK(!Eight::solvable(Eight::from_tiles({0, 2, 1, 3, 4, 5, 6, 7, 8})));
+    CHECK(Eight::solvable(Eight::from_tiles({1, 0, 2, 3, 4, 5, 6, 7, 8})));
+
+    CHECK_THROWS(Eight::from_tiles({1, 1, 2, 3, 4, 5, 6, 7, 8}),
+                 std::invalid_argument);
+    CHECK_THROWS(Eight::from_tiles({0, 0, 2, 3, 4, 5, 6, 7, 8}),
+                 std::invalid_argument);
+    CHECK_THROWS(Eight::from_tiles({0, 1, 2, 3, 4, 5, 6, 7, 9}),
+                 std::invalid_argument);
+    CHECK_THROWS(Eight::from_tiles({-1, 1, 2, 3, 4, 5, 6, 7, 8}),
+                 std::invalid_argument);
+}
+
+void test_trivial() {
+    ida::Search<Fifteen::State, Fifteen, ida::Manhattan<4, 4>> search;
+    const auto r = search.solve(Fifteen::goal());
+    CHECK(r.found);
+    CHECK(r.cost == 0);
+    CHECK(r.path.empty());
+    CHECK(r.iterations == 1);
+    CHECK(r.per_iteration.size() == 1);
+}
+
+void test_eight_puzzle() {
+    const Eight puzzle;
+    const auto distance = eight_puzzle_distances();
+    CHECK(distance.size() == 181440);
+
+    ida::Search<Eight::State, Eight, ida::Manhattan<3, 3>> search;
+    std::mt19937 rng(42);
+    for (int i = 0; i < 50; ++i) {
+        const Eight::State s =
+            ida_test::random_walk(puzzle, Eight::goal(), 20 + i, rng);
+        const auto r = search.solve(s);
+        CHECK(r.found);
+        CHECK(r.cost == distance.at(puzzle.hash(s)));
+        CHECK(ida_test::valid_path(puzzle, s, r.path, r.cost));
+        CHECK(r.per_iteration.size() == r.iterations);
+        for (std::size_t k = 1; k < r.per_iteration.size(); ++k)
+            CHECK(r.per_iteration[k].threshold >
+                  r.per_iteration[k - 1].threshold);
+    }
+
+    // An unsolvable instance has no solution within any bound.
+    const auto r =
+        search.solve(Eight::from_tiles({0, 2, 1, 3, 4, 5, 6, 7, 8}), 40);
+    CHECK(!r.found);
+}
+
+void test_korf_1() {
+    const Fifteen puzzle;
+    const Fifteen::State s = Fifteen::from_tiles(
+        {14, 13, 15, 7, 11, 12, 9, 5, 6, 0, 2, 1, 4, 8, 10, 3});
+    ida::Search<Fifteen::State, Fifteen, ida::Manhattan<4, 4>> search;
+
+    const auto bounded = search.solve(s, 55);
+    CHECK(!bounded.found);
+
+    const auto r = search.solve(s);
+    CHECK(r.found);
+    CHECK(r.cost == 57);
+    CHECK(ida_test::valid_path(puzzle, s, r.path, r.cost));
+}
+
+}  // namespace
+
+int main() {
+    test_domain();
+    test_trivial();
+    test_eight_puzzle();
+    test_korf_1();
+    return ida_test::report("search_test");
+}
@@ -0,0 +1,82 @@
+#include <ida/ida.hpp>
+#include <ida/parallel.hpp>
+#include <ida/sliding_tile.hpp>
+#include <ida/transposition_table.hpp>
+
+#include <cstddef>
+#include <random>
+#include <stdexcept>
+
+#include "check.hpp"
+
+namespace {
+
+using Fifteen = ida::FifteenPuzzle;
+using Heuristic = ida::Manhattan<4, 4>;
+
+void test_sizing() {
+    CHECK_THROWS(ida::TranspositionTable(0), std::invalid_argument);
+    CHECK_THROWS(ida::TranspositionTable(63), std::invalid_argument);
+
+    for (std::size_t max_bytes :
+         {std::size_t(64), std::size_t(100), std::size_t(4096),
+          std::size_t(5000), std::size_t(1) << 20, (std::size_t(3) << 20) + 1}) {
+        const ida::TranspositionTable table(max_bytes);
+        CHECK(table.memory_bytes() <= max_bytes);
+        // The largest power of two buckets that fits: doubling would not.
+        CHECK(table.memory_bytes() * 2 > max_bytes);
+        CHECK(table.capacity() ==
+              table.memory_bytes() / ida::TranspositionTable::bucket_bytes *
+                  ida::TranspositionTable::entries_per_bucket);
+    }
+}
+
+// Random walks solved with and without a table must agree on the cost, for
+// a table large enough to hold everything and for one small enough to be
+// under constant replacement pressure.
+void test_costs_unchanged() {
+    const Fifteen puzzle;
+    ida::Search<Fifteen::State, Fifteen, Heuristic> plain;
+
+    for (std::size_t max_bytes : {std::size_t(1) << 12, std::size_t(16) << 20}) {
+        ida::TranspositionTable table(max_bytes);
+        ida::Search<Fifteen::State, Fifteen, Heuristic,
+                    ida::TranspositionTable>
+            search(puzzle, Heuristic(), &table);
+        ida::ParallelOptions options;
+        options.threads = 3;
+        ida::ParallelSearch<Fifteen::State, Fifteen, Heuristic,
+                            ida::TranspositionTable>
+            parallel(puzzle, Heuristic(), options, &table);
+
+        std::mt19937 rng(5);
+        for (int i = 0; i < 10; ++i) {
+            const Fifteen::State s =
+                ida_test::random_walk(puzzle, Fifteen::goal(), 60, rng);
+            const auto expected = plain.solve(s);
+
+            table.reset_counters();
+            const auto r = search.solve(s);
+            CHECK(r.found);
+            CHECK(r.cost == expected.cost);
+            CHECK(r.nodes_expanded <= expected.nodes_expanded);
+            CHECK(ida_test::valid_path(puzzle, s, r.path, r.cost));
+            const auto counters = table.counters();
+            CHECK(counters.cutoffs <= counters.hits);
+
+            const auto p = parallel.solve(s);
+            CHECK(p.found);
+            CHECK(p.cost == expected.cost);
+            CHECK(ida_test::valid_path(puzzle, s, p.path, p.cost));
+        }
+        CHECK(table.memory_bytes() <= max_bytes);
+    }
+}
+
+}  // namespace
+
+int main() {
+    test_sizing();
+    test_costs_unchanged();
+    return ida_test::report("transposition_table_test");
+}